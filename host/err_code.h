@@ -0,0 +1,24 @@
+// Host stub of the mcu_port err_code.h, used to build the driver off target.
+
+#ifndef __ERR_CODE_H__
+#define __ERR_CODE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stdint.h"
+#include "string.h"
+
+typedef enum {
+	ERR_CODE_SUCCESS = 0,
+	ERR_CODE_FAIL,
+	ERR_CODE_NULL_PTR,
+	ERR_CODE_INVALID_ARG
+} err_code_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ERR_CODE_H__ */
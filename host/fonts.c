@@ -0,0 +1,18 @@
+#include "fonts.h"
+
+/* 5x8 glyphs derived from the character code, only cost and change matter */
+static uint8_t font_data[256][8];
+
+err_code_t get_font(uint8_t chr, font_size_t font_size, font_t *font)
+{
+	for (uint8_t row = 0; row < 8; row++) {
+		font_data[chr][row] = (uint8_t)((chr * (row + 3) * 37) ^ (row << 5)) & 0xF8;
+	}
+
+	font->width = 5;
+	font->height = 8;
+	font->data = font_data[chr];
+	font->data_len = sizeof(font_data[chr]);
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,30 @@
+// Host stub of the fonts component, used to build the driver off target.
+
+#ifndef __FONTS_H__
+#define __FONTS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+
+typedef enum {
+	FONT_SIZE_8 = 0,
+	FONT_SIZE_MAX
+} font_size_t;
+
+typedef struct {
+	uint8_t 				width;			/*!< Width in pixel */
+	uint8_t 				height;			/*!< Height in pixel */
+	const uint8_t 			*data;			/*!< Bitmap data */
+	uint16_t 				data_len;		/*!< Data length */
+} font_t;
+
+err_code_t get_font(uint8_t chr, font_size_t font_size, font_t *font);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FONTS_H__ */
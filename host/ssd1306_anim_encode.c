@@ -0,0 +1,86 @@
+// Host encoder of delta animation streams.
+//
+// Usage: ssd1306_anim_encode width height frames.raw stream.bin
+//
+// frames.raw holds the frames back to back, width * height / 8 bytes each,
+// in the page-major layout of the driver. The first frame is encoded
+// against a blank screen.
+//
+// Stream container:
+//   "SSDA" magic (4 bytes), width (1 byte), height (1 byte),
+//   number of frames (2 bytes, little endian), then the frames as produced
+//   by ssd1306_anim_encode. Play them in order with ssd1306_anim_play_frame,
+//   advancing by the number of bytes it consumed.
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "ssd1306.h"
+
+int main(int argc, char **argv)
+{
+	if (argc != 5) {
+		fprintf(stderr, "usage: %s width height frames.raw stream.bin\n", argv[0]);
+		return 1;
+	}
+
+	int width = atoi(argv[1]);
+	int height = atoi(argv[2]);
+	if ((width <= 0) || (width > 255) || (height <= 0) || (height > 64) || ((height % 8) != 0)) {
+		fprintf(stderr, "invalid size %dx%d\n", width, height);
+		return 1;
+	}
+
+	uint32_t buf_len = width * height / 8;
+	uint32_t frame_size = buf_len * 2;
+	uint8_t *prev = calloc(buf_len, 1);
+	uint8_t *next = calloc(buf_len, 1);
+	uint8_t *frame = calloc(frame_size, 1);
+
+	FILE *in = fopen(argv[3], "rb");
+	FILE *out = fopen(argv[4], "wb");
+	if ((prev == NULL) || (next == NULL) || (frame == NULL) || (in == NULL) || (out == NULL)) {
+		fprintf(stderr, "cannot open files\n");
+		return 1;
+	}
+
+	uint8_t header[8] = {'S', 'S', 'D', 'A', (uint8_t)width, (uint8_t)height, 0, 0};
+	fwrite(header, 1, sizeof(header), out);
+
+	uint32_t num_frame = 0;
+	uint32_t raw_bytes = 0;
+	uint32_t stream_bytes = 0;
+
+	while (fread(next, 1, buf_len, in) == buf_len) {
+		uint32_t frame_len;
+
+		if (ssd1306_anim_encode(prev, next, width, height, frame, frame_size, &frame_len) != ERR_CODE_SUCCESS) {
+			fprintf(stderr, "cannot encode frame %u\n", num_frame);
+			return 1;
+		}
+
+		fwrite(frame, 1, frame_len, out);
+		memcpy(prev, next, buf_len);
+
+		num_frame++;
+		raw_bytes += buf_len;
+		stream_bytes += frame_len;
+	}
+
+	if (num_frame > 0xFFFF) {
+		fprintf(stderr, "too many frames\n");
+		return 1;
+	}
+
+	header[6] = num_frame & 0xFF;
+	header[7] = num_frame >> 8;
+	fseek(out, 0, SEEK_SET);
+	fwrite(header, 1, sizeof(header), out);
+
+	fclose(in);
+	fclose(out);
+
+	printf("%u frames, %u raw bytes, %u stream bytes\n", num_frame, raw_bytes, stream_bytes);
+
+	return 0;
+}
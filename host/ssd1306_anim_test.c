@@ -0,0 +1,123 @@
+// Round-trip test of the delta animation encoder and player against a
+// GDDRAM model of the controller.
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "ssd1306.h"
+
+#define TEST_WIDTH 					128
+#define TEST_HEIGHT 				64
+#define TEST_BUF_LEN 				(TEST_WIDTH * TEST_HEIGHT / 8)
+#define TEST_NUM_FRAME 				50
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		return 1; \
+	} \
+} while (0)
+
+static uint8_t gddram[TEST_BUF_LEN];
+static uint8_t col_start, col_end, page_start, page_end, col, page;
+
+static err_code_t i2c_send(uint8_t reg_addr, uint8_t *buf_send, uint16_t len)
+{
+	if (reg_addr == 0x00) {
+		for (uint16_t i = 0; i < len; i++) {
+			if ((buf_send[i] == 0x21) && ((i + 2) < len)) {
+				col = col_start = buf_send[i + 1];
+				col_end = buf_send[i + 2];
+				i += 2;
+			} else if ((buf_send[i] == 0x22) && ((i + 2) < len)) {
+				page = page_start = buf_send[i + 1];
+				page_end = buf_send[i + 2];
+				i += 2;
+			}
+		}
+	} else {
+		for (uint16_t i = 0; i < len; i++) {
+			gddram[page * TEST_WIDTH + col] = buf_send[i];
+			if (++col > col_end) {
+				col = col_start;
+				if (++page > page_end) {
+					page = page_start;
+				}
+			}
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+int main(void)
+{
+	static uint8_t prev[TEST_BUF_LEN], next[TEST_BUF_LEN], frame[TEST_BUF_LEN * 2];
+	uint32_t frame_len, consumed;
+	ssd1306_stats_t stats;
+
+	ssd1306_cfg_t config = {
+		.width = TEST_WIDTH,
+		.height = TEST_HEIGHT,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	ssd1306_handle_t handle = ssd1306_init();
+	CHECK(ssd1306_set_config(handle, config) == ERR_CODE_SUCCESS);
+	CHECK(ssd1306_config(handle) == ERR_CODE_SUCCESS);
+	CHECK(ssd1306_refresh(handle) == ERR_CODE_SUCCESS);
+
+	srand(1);
+
+	/* Key frame, then frames with a few changed pixels */
+	for (int n = 0; n < TEST_NUM_FRAME; n++) {
+		if (n == 0) {
+			for (int i = 0; i < TEST_BUF_LEN; i++) {
+				next[i] = rand();
+			}
+		} else {
+			for (int i = 0; i < 40; i++) {
+				next[rand() % TEST_BUF_LEN] ^= 1 << (rand() % 8);
+			}
+		}
+
+		CHECK(ssd1306_anim_encode(prev, next, TEST_WIDTH, TEST_HEIGHT, frame, sizeof(frame), &frame_len) == ERR_CODE_SUCCESS);
+
+		ssd1306_reset_stats(handle);
+		CHECK(ssd1306_anim_play_frame(handle, frame, frame_len, &consumed) == ERR_CODE_SUCCESS);
+		ssd1306_get_stats(handle, &stats);
+
+		CHECK(consumed == frame_len);
+		CHECK(memcmp(gddram, next, TEST_BUF_LEN) == 0);
+		if (n != 0) {
+			CHECK(stats.bytes < TEST_BUF_LEN / 2);
+		}
+
+		memcpy(prev, next, TEST_BUF_LEN);
+	}
+
+	/* Truncated frame is rejected and changes nothing */
+	for (int i = 0; i < 40; i++) {
+		next[rand() % TEST_BUF_LEN] ^= 1 << (rand() % 8);
+	}
+	CHECK(ssd1306_anim_encode(prev, next, TEST_WIDTH, TEST_HEIGHT, frame, sizeof(frame), &frame_len) == ERR_CODE_SUCCESS);
+
+	ssd1306_reset_stats(handle);
+	CHECK(ssd1306_anim_play_frame(handle, frame, frame_len - 1, NULL) == ERR_CODE_INVALID_ARG);
+	ssd1306_get_stats(handle, &stats);
+	CHECK(stats.transactions == 0);
+	CHECK(memcmp(gddram, prev, TEST_BUF_LEN) == 0);
+
+	/* Span outside the panel is rejected */
+	uint8_t bad_frame[] = {2, 0, 0, 1, 0xFF, 8, 0, 1, 0xFF};
+	CHECK(ssd1306_anim_play_frame(handle, bad_frame, sizeof(bad_frame), NULL) == ERR_CODE_INVALID_ARG);
+	CHECK(memcmp(gddram, prev, TEST_BUF_LEN) == 0);
+
+	/* Width that does not fit the one-byte span fields is rejected */
+	CHECK(ssd1306_anim_encode(prev, next, 256, 8, frame, sizeof(frame), &frame_len) == ERR_CODE_INVALID_ARG);
+
+	printf("anim round-trip: %d frames OK\n", TEST_NUM_FRAME);
+
+	return 0;
+}
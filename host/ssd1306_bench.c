@@ -0,0 +1,325 @@
+// Host benchmark of the SSD1306 driver.
+//
+// Usage: ssd1306_bench [baseline.csv] [threshold]
+//
+// Prints "metric,value" lines (CSV) on stdout. When a baseline file is
+// given, every metric found in it is compared: bus metrics (*_bytes,
+// *_transactions) fail when larger than baseline, *_ns metrics fail when
+// slower than baseline * threshold (default 4). A threshold of 0 skips
+// the *_ns metrics, whose values depend on the machine and build type.
+// Redirect stdout to the baseline file to update it.
+//
+// Bus workloads:
+//  - full: ssd1306_refresh of a full redraw,
+//  - counter: a 4-digit counter going from 0041 to 0042, sent with
+//    ssd1306_anim_play_frame,
+//  - graph: a curve scrolled by one sample per frame over BENCH_NUM_SCROLL
+//    frames, sent with ssd1306_anim_play_frame, totals per frame.
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "ssd1306.h"
+
+#define BENCH_WIDTH 				128
+#define BENCH_HEIGHT 				64
+#define BENCH_NUM_ITER 				2000
+#define BENCH_NUM_REPEAT 			5
+#define BENCH_MAX_METRIC 			32
+#define BENCH_DEFAULT_THRESHOLD 	4.0
+#define BENCH_BUF_LEN 				(BENCH_WIDTH * BENCH_HEIGHT / 8)
+#define BENCH_NUM_SCROLL 			16
+
+typedef struct {
+	char 					name[48];
+	double 					value;
+} metric_t;
+
+static metric_t metrics[BENCH_MAX_METRIC];
+static int num_metric;
+static ssd1306_handle_t handle;
+static uint8_t bitmap[BENCH_WIDTH * BENCH_HEIGHT / 8];
+
+static err_code_t i2c_send(uint8_t reg_addr, uint8_t *buf_send, uint16_t len)
+{
+	return ERR_CODE_SUCCESS;
+}
+
+static double time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void add_metric(const char *name, double value)
+{
+	snprintf(metrics[num_metric].name, sizeof(metrics[num_metric].name), "%s", name);
+	metrics[num_metric].value = value;
+	num_metric++;
+	printf("%s,%.0f\n", name, value);
+}
+
+static void op_pixel(int i)
+{
+	ssd1306_draw_pixel(handle, i % BENCH_WIDTH, i % BENCH_HEIGHT, SSD1306_COLOR_WHITE);
+}
+
+static void op_line(int i)
+{
+	ssd1306_draw_line(handle, 0, 0, BENCH_WIDTH - 1, BENCH_HEIGHT - 1, SSD1306_COLOR_WHITE);
+}
+
+static void op_circle(int i)
+{
+	ssd1306_draw_circle(handle, BENCH_WIDTH / 2, BENCH_HEIGHT / 2, 20, SSD1306_COLOR_WHITE);
+}
+
+static void op_rectangle(int i)
+{
+	ssd1306_draw_rectangle(handle, 10, 10, 100, 40, SSD1306_COLOR_WHITE);
+}
+
+static void op_bitmap(int i)
+{
+	ssd1306_draw_bitmap(handle, 0, 0, BENCH_WIDTH, BENCH_HEIGHT, bitmap);
+}
+
+static void op_char(int i)
+{
+	ssd1306_set_position(handle, 0, 0);
+	ssd1306_write_char(handle, FONT_SIZE_8, 'A');
+}
+
+static void op_string(int i)
+{
+	ssd1306_set_position(handle, 0, 0);
+	ssd1306_write_string(handle, FONT_SIZE_8, (uint8_t *)"Hello, world");
+}
+
+static void op_fill(int i)
+{
+	ssd1306_fill(handle, SSD1306_COLOR_WHITE);
+}
+
+static void op_clear(int i)
+{
+	ssd1306_clear(handle);
+}
+
+static void bench_op(const char *name, void (*op)(int))
+{
+	double best = 0;
+
+	for (int repeat = 0; repeat < BENCH_NUM_REPEAT; repeat++) {
+		double start = time_ns();
+		for (int i = 0; i < BENCH_NUM_ITER; i++) {
+			op(i);
+		}
+		double elapsed = (time_ns() - start) / BENCH_NUM_ITER;
+
+		if ((repeat == 0) || (elapsed < best)) {
+			best = elapsed;
+		}
+	}
+
+	char metric[48];
+	snprintf(metric, sizeof(metric), "%s_ns", name);
+	add_metric(metric, best);
+}
+
+static void add_stats(const char *name, const ssd1306_stats_t *stats, uint32_t num_frame)
+{
+	char metric[48];
+
+	snprintf(metric, sizeof(metric), "%s_bytes", name);
+	add_metric(metric, stats->bytes / num_frame);
+	snprintf(metric, sizeof(metric), "%s_transactions", name);
+	add_metric(metric, stats->transactions / num_frame);
+}
+
+/* Send the change made by draw() as a delta frame, bus counters accumulate */
+static void play_delta(void (*draw)(int), int arg)
+{
+	static uint8_t prev[BENCH_BUF_LEN], next[BENCH_BUF_LEN], frame[BENCH_BUF_LEN * 2];
+	uint32_t frame_len;
+	uint8_t *buf;
+
+	ssd1306_get_buffer(handle, &buf);
+	memcpy(prev, buf, BENCH_BUF_LEN);
+
+	draw(arg);
+
+	ssd1306_get_buffer(handle, &buf);
+	memcpy(next, buf, BENCH_BUF_LEN);
+	memcpy(buf, prev, BENCH_BUF_LEN);
+
+	ssd1306_anim_encode(prev, next, BENCH_WIDTH, BENCH_HEIGHT, frame, sizeof(frame), &frame_len);
+	ssd1306_anim_play_frame(handle, frame, frame_len, NULL);
+}
+
+static void draw_screen(void)
+{
+	ssd1306_clear(handle);
+	ssd1306_draw_rectangle(handle, 0, 0, BENCH_WIDTH - 1, BENCH_HEIGHT - 1, SSD1306_COLOR_WHITE);
+	ssd1306_draw_circle(handle, BENCH_WIDTH / 2, BENCH_HEIGHT / 2, 20, SSD1306_COLOR_WHITE);
+	ssd1306_set_position(handle, 4, 4);
+	ssd1306_write_string(handle, FONT_SIZE_8, (uint8_t *)"Status");
+}
+
+static void draw_counter(int value)
+{
+	char text[8];
+
+	snprintf(text, sizeof(text), "%04d", value);
+	ssd1306_set_position(handle, 4, 16);
+	ssd1306_write_string(handle, FONT_SIZE_8, (uint8_t *)text);
+}
+
+static void draw_graph(int offset)
+{
+	ssd1306_clear(handle);
+	for (int x = 1; x < BENCH_WIDTH; x++) {
+		int y0 = ((x - 1 + offset) * 7) % BENCH_HEIGHT;
+		int y1 = ((x + offset) * 7) % BENCH_HEIGHT;
+		ssd1306_draw_line(handle, x - 1, y0, x, y1, SSD1306_COLOR_WHITE);
+	}
+}
+
+static void workload_full(void)
+{
+	ssd1306_stats_t stats;
+
+	draw_screen();
+
+	ssd1306_reset_stats(handle);
+	ssd1306_refresh(handle);
+	ssd1306_get_stats(handle, &stats);
+	add_stats("refresh_full", &stats, 1);
+}
+
+static void workload_counter(void)
+{
+	ssd1306_stats_t stats;
+
+	draw_screen();
+	draw_counter(41);
+	ssd1306_refresh(handle);
+
+	ssd1306_reset_stats(handle);
+	play_delta(draw_counter, 42);
+	ssd1306_get_stats(handle, &stats);
+	add_stats("counter", &stats, 1);
+}
+
+static void workload_graph(void)
+{
+	ssd1306_stats_t stats;
+
+	draw_graph(0);
+	ssd1306_refresh(handle);
+
+	ssd1306_reset_stats(handle);
+	for (int offset = 1; offset <= BENCH_NUM_SCROLL; offset++) {
+		play_delta(draw_graph, offset);
+	}
+	ssd1306_get_stats(handle, &stats);
+	add_stats("graph", &stats, BENCH_NUM_SCROLL);
+}
+
+static int compare_baseline(const char *path, double threshold)
+{
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		fprintf(stderr, "cannot open baseline %s\n", path);
+		return 1;
+	}
+
+	char line[128];
+	int num_fail = 0;
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char name[48];
+		double baseline;
+
+		if (sscanf(line, "%47[^,],%lf", name, &baseline) != 2) {
+			continue;
+		}
+
+		metric_t *metric = NULL;
+		for (int i = 0; i < num_metric; i++) {
+			if (strcmp(metrics[i].name, name) == 0) {
+				metric = &metrics[i];
+			}
+		}
+
+		if (metric == NULL) {
+			fprintf(stderr, "FAIL %s: missing\n", name);
+			num_fail++;
+			continue;
+		}
+
+		int is_time = (strstr(name, "_ns") != NULL);
+		if (is_time && (threshold <= 0)) {
+			continue;
+		}
+
+		double limit = is_time ? baseline * threshold : baseline;
+
+		if (metric->value > limit) {
+			fprintf(stderr, "FAIL %s: %.0f > %.0f (baseline %.0f)\n", name, metric->value, limit, baseline);
+			num_fail++;
+		}
+	}
+
+	fclose(file);
+
+	return num_fail;
+}
+
+int main(int argc, char **argv)
+{
+	double threshold = (argc > 2) ? atof(argv[2]) : BENCH_DEFAULT_THRESHOLD;
+
+	ssd1306_cfg_t config = {
+		.width = BENCH_WIDTH,
+		.height = BENCH_HEIGHT,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	for (size_t i = 0; i < sizeof(bitmap); i++) {
+		bitmap[i] = (uint8_t)(i * 37);
+	}
+
+	handle = ssd1306_init();
+	ssd1306_set_config(handle, config);
+	ssd1306_config(handle);
+
+	bench_op("pixel", op_pixel);
+	bench_op("line", op_line);
+	bench_op("circle", op_circle);
+	bench_op("rectangle", op_rectangle);
+	bench_op("bitmap", op_bitmap);
+	bench_op("char", op_char);
+	bench_op("string", op_string);
+	bench_op("fill", op_fill);
+	bench_op("clear", op_clear);
+
+	workload_full();
+	workload_counter();
+	workload_graph();
+
+	if (argc > 1) {
+		int num_fail = compare_baseline(argv[1], threshold);
+		if (num_fail != 0) {
+			fprintf(stderr, "%d metric(s) regressed\n", num_fail);
+			return 1;
+		}
+	}
+
+	return 0;
+}
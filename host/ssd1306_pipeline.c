@@ -0,0 +1,227 @@
+// Pipelined band rendering against an emulated transport.
+//
+// Usage: ssd1306_pipeline [num_worker]
+//
+// Renders the same frames twice through ssd1306_refresh_stream:
+//  - single-threaded: the render callback rasterizes each band itself,
+//  - pipelined: worker threads rasterize bands into the buffer while the
+//    main thread streams finished bands.
+// The emulated transport models GDDRAM and takes BUS_NS_PER_BYTE per byte,
+// about a 1 MHz I2C bus. Fails if both paths do not produce the same
+// GDDRAM content, prints both times and the speedup.
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "pthread.h"
+#include "ssd1306.h"
+
+#define PIPE_WIDTH 					128
+#define PIPE_HEIGHT 				64
+#define PIPE_NUM_PAGE 				(PIPE_HEIGHT / 8)
+#define PIPE_BUF_LEN 				(PIPE_WIDTH * PIPE_HEIGHT / 8)
+#define PIPE_NUM_FRAME 				10
+#define PIPE_MAX_WORKER 			8
+#define PIPE_MAX_ITER 				192
+#define BUS_NS_PER_BYTE 			9000
+
+typedef struct {
+	uint8_t 				*buf;
+	int 					frame;
+	int 					next_page;
+	int 					ready[PIPE_NUM_PAGE];
+	pthread_mutex_t 		lock;
+	pthread_cond_t 			cond;
+} pipeline_t;
+
+static uint8_t gddram[PIPE_BUF_LEN];
+static uint8_t col_start, col_end, page_start, page_end, col, page;
+
+static err_code_t i2c_send(uint8_t reg_addr, uint8_t *buf_send, uint16_t len)
+{
+	if (reg_addr == 0x00) {
+		for (uint16_t i = 0; i < len; i++) {
+			if ((buf_send[i] == 0x21) && ((i + 2) < len)) {
+				col = col_start = buf_send[i + 1];
+				col_end = buf_send[i + 2];
+				i += 2;
+			} else if ((buf_send[i] == 0x22) && ((i + 2) < len)) {
+				page = page_start = buf_send[i + 1];
+				page_end = buf_send[i + 2];
+				i += 2;
+			}
+		}
+	} else {
+		for (uint16_t i = 0; i < len; i++) {
+			gddram[page * PIPE_WIDTH + col] = buf_send[i];
+			if (++col > col_end) {
+				col = col_start;
+				if (++page > page_end) {
+					page = page_start;
+				}
+			}
+		}
+	}
+
+	/* Bus time, the CPU is free meanwhile as with DMA */
+	struct timespec ts = {0, (long)len * BUS_NS_PER_BYTE};
+	nanosleep(&ts, NULL);
+
+	return ERR_CODE_SUCCESS;
+}
+
+static double time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* Mandelbrot zoom, thresholded by a checker pattern on the iteration count */
+static void render_page(uint8_t *buf, int frame, int page)
+{
+	double scale = 3.0 / (PIPE_WIDTH * (1.0 + frame * 0.2));
+
+	for (int x = 0; x < PIPE_WIDTH; x++) {
+		uint8_t byte = 0;
+
+		for (int bit = 0; bit < 8; bit++) {
+			double cr = -0.75 + (x - PIPE_WIDTH / 2) * scale;
+			double ci = 0.1 + (page * 8 + bit - PIPE_HEIGHT / 2) * scale;
+			double zr = 0, zi = 0;
+			int iter = 0;
+
+			while ((iter < PIPE_MAX_ITER) && ((zr * zr + zi * zi) < 4.0)) {
+				double tmp = zr * zr - zi * zi + cr;
+				zi = 2 * zr * zi + ci;
+				zr = tmp;
+				iter++;
+			}
+
+			if ((iter == PIPE_MAX_ITER) || (iter & 1)) {
+				byte |= (1 << bit);
+			}
+		}
+
+		buf[page * PIPE_WIDTH + x] = byte;
+	}
+}
+
+static err_code_t render_inline(ssd1306_handle_t handle, uint8_t first, uint8_t last, void *arg)
+{
+	pipeline_t *pipe = arg;
+
+	for (int p = first; p <= last; p++) {
+		render_page(pipe->buf, pipe->frame, p);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static void *worker(void *arg)
+{
+	pipeline_t *pipe = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&pipe->lock);
+		int p = pipe->next_page++;
+		pthread_mutex_unlock(&pipe->lock);
+
+		if (p >= PIPE_NUM_PAGE) {
+			return NULL;
+		}
+
+		render_page(pipe->buf, pipe->frame, p);
+
+		pthread_mutex_lock(&pipe->lock);
+		pipe->ready[p] = 1;
+		pthread_cond_broadcast(&pipe->cond);
+		pthread_mutex_unlock(&pipe->lock);
+	}
+}
+
+static err_code_t wait_band(ssd1306_handle_t handle, uint8_t first, uint8_t last, void *arg)
+{
+	pipeline_t *pipe = arg;
+
+	pthread_mutex_lock(&pipe->lock);
+	for (int p = first; p <= last; p++) {
+		while (!pipe->ready[p]) {
+			pthread_cond_wait(&pipe->cond, &pipe->lock);
+		}
+	}
+	pthread_mutex_unlock(&pipe->lock);
+
+	return ERR_CODE_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t result[PIPE_NUM_FRAME][PIPE_BUF_LEN];
+	int num_worker = (argc > 1) ? atoi(argv[1]) : 2;
+	pipeline_t pipe;
+
+	if ((num_worker < 1) || (num_worker > PIPE_MAX_WORKER)) {
+		fprintf(stderr, "number of workers must be 1..%d\n", PIPE_MAX_WORKER);
+		return 1;
+	}
+
+	ssd1306_cfg_t config = {
+		.width = PIPE_WIDTH,
+		.height = PIPE_HEIGHT,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	ssd1306_handle_t handle = ssd1306_init();
+	ssd1306_set_config(handle, config);
+	ssd1306_config(handle);
+	ssd1306_get_buffer(handle, &pipe.buf);
+	pthread_mutex_init(&pipe.lock, NULL);
+	pthread_cond_init(&pipe.cond, NULL);
+
+	/* Single-threaded: render a band, send it, render the next one */
+	double start = time_ms();
+	for (int frame = 0; frame < PIPE_NUM_FRAME; frame++) {
+		pipe.frame = frame;
+		ssd1306_refresh_stream(handle, 1, render_inline, &pipe);
+		memcpy(result[frame], gddram, PIPE_BUF_LEN);
+	}
+	double single_ms = time_ms() - start;
+
+	/* Pipelined: workers rasterize while finished bands are streamed */
+	start = time_ms();
+	for (int frame = 0; frame < PIPE_NUM_FRAME; frame++) {
+		pthread_t threads[PIPE_MAX_WORKER];
+
+		pipe.frame = frame;
+		pipe.next_page = 0;
+		memset(pipe.ready, 0, sizeof(pipe.ready));
+
+		for (int i = 0; i < num_worker; i++) {
+			pthread_create(&threads[i], NULL, worker, &pipe);
+		}
+
+		ssd1306_refresh_stream(handle, 1, wait_band, &pipe);
+
+		for (int i = 0; i < num_worker; i++) {
+			pthread_join(threads[i], NULL);
+		}
+
+		if (memcmp(result[frame], gddram, PIPE_BUF_LEN) != 0) {
+			fprintf(stderr, "frame %d differs between single-threaded and pipelined\n", frame);
+			return 1;
+		}
+	}
+	double pipelined_ms = time_ms() - start;
+
+	printf("single_ms,%.1f\n", single_ms / PIPE_NUM_FRAME);
+	printf("pipelined_ms,%.1f\n", pipelined_ms / PIPE_NUM_FRAME);
+	printf("workers,%d\n", num_worker);
+	printf("speedup,%.2f\n", single_ms / pipelined_ms);
+
+	return 0;
+}
@@ -0,0 +1,218 @@
+// Test of screen transitions against a model of GDDRAM and the display
+// start line.
+
+#include "stdio.h"
+#include "string.h"
+#include "ssd1306.h"
+
+#define TEST_WIDTH 					128
+#define GDDRAM_NUM_PAGE 			8
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		return 1; \
+	} \
+} while (0)
+
+static uint8_t gddram[GDDRAM_NUM_PAGE * TEST_WIDTH];
+static uint8_t col_start, col_end, page_start, page_end, col, page, start_line;
+static uint8_t expect_cmd_arg;
+
+/* Visible pages checked after every transaction while watch_num_page != 0 */
+static uint8_t watch_num_page, watch_offset, watch_fail;
+
+static void watch_visible(void);
+
+static err_code_t i2c_send(uint8_t reg_addr, uint8_t *buf_send, uint16_t len)
+{
+	if (reg_addr == 0x00) {
+		for (uint16_t i = 0; i < len; i++) {
+			if (expect_cmd_arg != 0) {
+				expect_cmd_arg--;
+			} else if ((buf_send[i] == 0x21) && ((i + 2) < len)) {
+				col = col_start = buf_send[i + 1];
+				col_end = buf_send[i + 2];
+				i += 2;
+			} else if ((buf_send[i] == 0x22) && ((i + 2) < len)) {
+				page = page_start = buf_send[i + 1];
+				page_end = buf_send[i + 2];
+				i += 2;
+			} else if ((buf_send[i] >= 0x40) && (buf_send[i] <= 0x7F)) {
+				start_line = buf_send[i] - 0x40;
+			} else if ((buf_send[i] == 0x81) || (buf_send[i] == 0xA8) || (buf_send[i] == 0xD3) ||
+			           (buf_send[i] == 0xD5) || (buf_send[i] == 0xD9) || (buf_send[i] == 0xDA) ||
+			           (buf_send[i] == 0xDB) || (buf_send[i] == 0x8D) || (buf_send[i] == 0x20)) {
+				expect_cmd_arg = 1;
+			}
+		}
+	} else {
+		for (uint16_t i = 0; i < len; i++) {
+			gddram[page * TEST_WIDTH + col] = buf_send[i];
+			if (++col > col_end) {
+				col = col_start;
+				if (++page > page_end) {
+					page = page_start;
+				}
+			}
+		}
+	}
+
+	if (watch_num_page != 0) {
+		watch_visible();
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+/* Page of GDDRAM shown at display page, start line is page-aligned here */
+static uint8_t shown(uint8_t display_page, uint8_t col_idx)
+{
+	return gddram[((display_page + start_line / 8) % GDDRAM_NUM_PAGE) * TEST_WIDTH + col_idx];
+}
+
+/* Slide state with offset pages done: old pages offset.. then new pages 0.. */
+static uint8_t slide_expected(uint8_t num_page, uint8_t offset, uint8_t display_page)
+{
+	if (display_page < (num_page - offset)) {
+		return 0x10 + offset + display_page;
+	}
+
+	return 0x20 + display_page - (num_page - offset);
+}
+
+static void watch_visible(void)
+{
+	/* The screen only moves forward through valid slide states */
+	for (uint8_t offset = watch_offset; offset <= watch_num_page; offset++) {
+		uint8_t match = 1;
+
+		for (uint8_t d = 0; d < watch_num_page; d++) {
+			if (shown(d, 0) != slide_expected(watch_num_page, offset, d)) {
+				match = 0;
+				break;
+			}
+		}
+
+		if (match) {
+			watch_offset = offset;
+			return;
+		}
+	}
+
+	if (!watch_fail) {
+		fprintf(stderr, "invalid visible frame:");
+		for (uint8_t d = 0; d < watch_num_page; d++) {
+			fprintf(stderr, " %02X", shown(d, 0));
+		}
+		fprintf(stderr, "\n");
+	}
+	watch_fail = 1;
+}
+
+static int test_slide(uint16_t height, uint8_t num_step)
+{
+	uint8_t num_page = height / 8;
+	uint8_t *buf;
+
+	ssd1306_cfg_t config = {
+		.width = TEST_WIDTH,
+		.height = height,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	/* Stale data in the rows that are not shown */
+	memset(gddram, 0xA5, sizeof(gddram));
+
+	ssd1306_handle_t handle = ssd1306_init();
+	CHECK(ssd1306_set_config(handle, config) == ERR_CODE_SUCCESS);
+	CHECK(ssd1306_config(handle) == ERR_CODE_SUCCESS);
+	ssd1306_get_buffer(handle, &buf);
+
+	/* Old screen: page p is 0x10 + p, new screen: page p is 0x20 + p */
+	for (uint8_t p = 0; p < num_page; p++) {
+		memset(&buf[p * TEST_WIDTH], 0x10 + p, TEST_WIDTH);
+	}
+	ssd1306_refresh(handle);
+	for (uint8_t p = 0; p < num_page; p++) {
+		memset(&buf[p * TEST_WIDTH], 0x20 + p, TEST_WIDTH);
+	}
+
+	/* 64-row panels have no hidden rows, only 32-row ones are checked
+	 * after every transaction */
+	watch_num_page = (height == 32) ? num_page : 0;
+	watch_offset = 0;
+	watch_fail = 0;
+
+	for (uint8_t step = 1; step <= num_step; step++) {
+		uint8_t done = num_page * step / num_step;
+
+		CHECK(ssd1306_transition_step(handle, SSD1306_TRANSITION_SLIDE_UP, step, num_step) == ERR_CODE_SUCCESS);
+
+		/* Old pages moved up, new pages below them, nothing stale */
+		for (uint8_t d = 0; d < num_page; d++) {
+			uint8_t expected = slide_expected(num_page, done, d);
+			if (shown(d, 0) != expected) {
+				fprintf(stderr, "height %d step %d/%d display page %d: 0x%02X, expected 0x%02X\n",
+				        height, step, num_step, d, shown(d, 0), expected);
+				return 1;
+			}
+		}
+	}
+
+	watch_num_page = 0;
+	CHECK(watch_fail == 0);
+	CHECK(start_line == 0);
+
+	return 0;
+}
+
+static int test_wipe(void)
+{
+	ssd1306_stats_t stats;
+	uint8_t *buf;
+
+	ssd1306_cfg_t config = {
+		.width = TEST_WIDTH,
+		.height = 64,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	ssd1306_handle_t handle = ssd1306_init();
+	CHECK(ssd1306_set_config(handle, config) == ERR_CODE_SUCCESS);
+	CHECK(ssd1306_config(handle) == ERR_CODE_SUCCESS);
+	ssd1306_refresh(handle);
+	ssd1306_get_buffer(handle, &buf);
+
+	for (int i = 0; i < TEST_WIDTH * 8; i++) {
+		buf[i] = (uint8_t)(i * 13);
+	}
+
+	/* 16 columns x 8 pages per step: one window, one data transaction */
+	for (uint8_t step = 1; step <= 8; step++) {
+		ssd1306_reset_stats(handle);
+		CHECK(ssd1306_transition_step(handle, SSD1306_TRANSITION_WIPE_LEFT, step, 8) == ERR_CODE_SUCCESS);
+		ssd1306_get_stats(handle, &stats);
+		CHECK(stats.transactions == 2);
+		CHECK(stats.bytes == 6 + 128);
+	}
+
+	CHECK(memcmp(gddram, buf, TEST_WIDTH * 8) == 0);
+
+	return 0;
+}
+
+int main(void)
+{
+	CHECK(test_slide(32, 1) == 0);
+	CHECK(test_slide(32, 2) == 0);
+	CHECK(test_slide(32, 4) == 0);
+	CHECK(test_slide(64, 4) == 0);
+	CHECK(test_wipe() == 0);
+
+	printf("transition: OK\n");
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+// Test of UTF-8 decoding and glyph lookup of ssd1306_write_utf8.
+
+#include "stdio.h"
+#include "ssd1306.h"
+
+#define CHECK_ADVANCE(str, expected) do { \
+	uint8_t x, y; \
+	ssd1306_set_position(handle, 0, 0); \
+	ssd1306_write_utf8(handle, &font, (const uint8_t *)(str)); \
+	ssd1306_get_position(handle, &x, &y); \
+	if (x != (expected)) { \
+		fprintf(stderr, "%s:%d: advance of %s is %d, expected %d\n", __FILE__, __LINE__, #str, x, (expected)); \
+		return 1; \
+	} \
+} while (0)
+
+static err_code_t i2c_send(uint8_t reg_addr, uint8_t *buf_send, uint16_t len)
+{
+	return ERR_CODE_SUCCESS;
+}
+
+int main(void)
+{
+	static const uint8_t bitmap[] = {0xFF};
+
+	/* 'A' advances 10, U+4E2D advances 20, U+1F600 advances 30, U+FFFD advances 1 */
+	static const ssd1306_glyph_range_t ranges[] = {
+		{'A', 1, 0},
+		{0x4E2D, 1, 1},
+		{0xFFFD, 1, 2},
+		{0x1F600, 1, 3},
+	};
+	static const ssd1306_glyph_t glyphs[] = {
+		{0, 8, 10},
+		{0, 8, 20},
+		{0, 8, 1},
+		{0, 8, 30},
+	};
+
+	/* No fallback glyph, missing code points advance 0 */
+	ssd1306_font_t font = {1, ranges, 4, glyphs, bitmap, 0};
+
+	ssd1306_cfg_t config = {
+		.width = 128,
+		.height = 64,
+		.comm_mode = SSD1306_COMM_MODE_I2C,
+		.i2c_send = i2c_send,
+	};
+
+	ssd1306_handle_t handle = ssd1306_init();
+	ssd1306_set_config(handle, config);
+	ssd1306_config(handle);
+
+	CHECK_ADVANCE("A", 10);
+	CHECK_ADVANCE("B", 0);
+	CHECK_ADVANCE("\xE4\xB8\xAD", 20);
+	CHECK_ADVANCE("\xF0\x9F\x98\x80", 30);
+
+	/* Overlong forms */
+	CHECK_ADVANCE("\xC0\x80", 2);
+	CHECK_ADVANCE("\xC1\xBF", 2);
+	CHECK_ADVANCE("\xE0\x81\x81", 1);
+	CHECK_ADVANCE("\xF0\x80\x81\x81", 1);
+
+	/* Surrogates and values beyond U+10FFFF */
+	CHECK_ADVANCE("\xED\xA0\x80", 1);
+	CHECK_ADVANCE("\xED\xBF\xBF", 1);
+	CHECK_ADVANCE("\xF4\x90\x80\x80", 1);
+	CHECK_ADVANCE("\xF5\x80\x80\x80", 4);
+
+	/* Truncated sequence followed by a valid character */
+	CHECK_ADVANCE("\xE4\xB8" "A", 11);
+
+	printf("utf8: OK\n");
+
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include "stdlib.h"
+#include "string.h"
 #include "ssd1306.h"
 
 #define SSD1306_REG_DATA_ADDR				0x40
@@ -40,10 +41,24 @@
 
 #define NUM_OF_BUF  						2
 
+#define ANIM_SPAN_HEADER_LEN 				3			/*!< Page + column + length */
+#define ANIM_SPAN_MERGE_GAP 				ANIM_SPAN_HEADER_LEN
+
+#define GDDRAM_NUM_PAGE 					8
+#define WIPE_BUF_LEN 						128
+
+#define UTF8_REPLACEMENT_CHAR 				0xFFFD
+
+#define INIT_SEQ_IDX_CONTRAST 				6
+#define INIT_SEQ_IDX_DISPLAY_MODE 			8
+#define INIT_SEQ_IDX_MULTIPLEX 				10
+#define INIT_SEQ_IDX_COMPINS 				19
+
 #define SPI_CS_ACTIVE  						0
 #define SPI_CS_UNACTIVE  					1
 
 typedef err_code_t (*write_cmd_func)(ssd1306_handle_t handle, uint8_t cmd);
+typedef err_code_t (*write_cmds_func)(ssd1306_handle_t handle, uint8_t *cmds, uint16_t len);
 typedef err_code_t (*write_data_func)(ssd1306_handle_t handle, uint8_t *data, uint16_t len);
 
 typedef struct ssd1306 {
@@ -56,15 +71,60 @@ typedef struct ssd1306 {
 	ssd1306_func_set_rst 	set_rst;				/*!< Function set RST. Used in SPI mode */
 	ssd1306_func_spi_send 	spi_send;				/*!< Function send SPI data */
 	ssd1306_func_i2c_send 	i2c_send;				/*!< Function send I2C data */
+	ssd1306_func_get_time_us get_time_us;			/*!< Function get time in microsecond */
+	uint8_t 				warm_start;				/*!< Warm start mode */
+	uint8_t 				*splash;				/*!< Splash framebuffer */
+	uint8_t 				page_flip;				/*!< Page flip mode */
 	write_cmd_func 			write_cmd; 				/*!< Function write command */
+	write_cmds_func 		write_cmds; 			/*!< Function write command burst */
 	write_data_func  		write_data;				/*!< Function write data */
 	uint8_t 				*buf[NUM_OF_BUF];		/*!< Data buffer */
 	uint32_t 				buf_len;				/*!< Buffer length */
 	uint8_t					buf_idx;				/*!< Buffer index */
 	uint16_t 				pos_x;					/*!< Position x */
 	uint16_t  				pos_y;					/*!< Position y */
+	uint32_t 				time_config;			/*!< Time when configuration started */
+	uint32_t 				time_first_frame;		/*!< Time to first frame */
+	uint8_t 				first_frame_done;		/*!< First frame has been sent */
+	uint8_t 				start_page;				/*!< GDDRAM page shown at the top of the screen */
+	ssd1306_stats_t 		stats;					/*!< Bus statistics */
+	uint8_t 				contrast;				/*!< Contrast */
+	int16_t 				*dither_err;			/*!< Error diffusion scratch, two rows */
 } ssd1306_t;
 
+/* 8x8 Bayer threshold matrix */
+static const uint8_t bayer_matrix[8][8] = {
+	{ 0, 32,  8, 40,  2, 34, 10, 42},
+	{48, 16, 56, 24, 50, 18, 58, 26},
+	{12, 44,  4, 36, 14, 46,  6, 38},
+	{60, 28, 52, 20, 62, 30, 54, 22},
+	{ 3, 35, 11, 43,  1, 33,  9, 41},
+	{51, 19, 59, 27, 49, 17, 57, 25},
+	{15, 47,  7, 39, 13, 45,  5, 37},
+	{63, 31, 55, 23, 61, 29, 53, 21}
+};
+
+/* Initialization sequence, sent as a single command burst. Entries at
+ * INIT_SEQ_IDX_* depend on configuration and are patched before sending. */
+static const uint8_t ssd1306_init_seq[] = {
+	SSD1306_DISPLAY_OFF,
+	SSD1306_SET_MEMORYMODE, SSD1306_SET_MEMORYMODE_HOR,
+	SSD1306_COMSCAN_DEC,
+	SSD1306_SET_STARTLINE_ZERO,
+	SSD1306_SET_CONTRAST, 0xFF,
+	SSD1306_SET_SEGREMAP_INV,
+	SSD1306_DISPLAY_NORMAL,
+	SSD1306_SET_MULTIPLEX, 0x3F,
+	SSD1306_DISPLAYALLON_RESUME,
+	SSD1306_SET_DISPLAYOFFSET, 0x00,
+	SSD1306_SET_CLKDIV, 0xF0,
+	SSD1306_SET_PRECHARGE, 0x22,
+	SSD1306_SET_COMPINS, 0x12,
+	SSD1306_SET_COMDESELECT, 0x20,
+	SSD1306_CHARGEPUMP, SSD1306_CHARGEPUMP_ON,
+	SSD1306_DISPLAY_ON
+};
+
 static void draw_pixel(ssd1306_handle_t handle, uint8_t x, uint8_t y, ssd1306_color_t color)
 {
 	if (handle->inverse) {
@@ -144,6 +204,110 @@ static void draw_line(ssd1306_handle_t handle, uint8_t x_start, uint8_t y_start,
 	}
 }
 
+static uint32_t utf8_decode(const uint8_t **str)
+{
+	const uint8_t *s = *str;
+	uint32_t code;
+	uint32_t code_min;
+	uint8_t num_cont;
+
+	/* C0, C1 only start overlong forms, F5+ exceed U+10FFFF */
+	if (s[0] < 0x80) {
+		*str = s + 1;
+		return s[0];
+	} else if ((s[0] >= 0xC2) && (s[0] <= 0xDF)) {
+		code = s[0] & 0x1F;
+		code_min = 0x80;
+		num_cont = 1;
+	} else if ((s[0] & 0xF0) == 0xE0) {
+		code = s[0] & 0x0F;
+		code_min = 0x800;
+		num_cont = 2;
+	} else if ((s[0] >= 0xF0) && (s[0] <= 0xF4)) {
+		code = s[0] & 0x07;
+		code_min = 0x10000;
+		num_cont = 3;
+	} else {
+		*str = s + 1;
+		return UTF8_REPLACEMENT_CHAR;
+	}
+
+	for (uint8_t i = 1; i <= num_cont; i++) {
+		if ((s[i] & 0xC0) != 0x80) {
+			*str = s + i;
+			return UTF8_REPLACEMENT_CHAR;
+		}
+		code = (code << 6) | (s[i] & 0x3F);
+	}
+
+	*str = s + num_cont + 1;
+
+	/* Overlong forms, UTF-16 surrogates and values beyond Unicode */
+	if ((code < code_min) || ((code >= 0xD800) && (code <= 0xDFFF)) || (code > 0x10FFFF)) {
+		return UTF8_REPLACEMENT_CHAR;
+	}
+
+	return code;
+}
+
+static const ssd1306_glyph_t *find_glyph(const ssd1306_font_t *font, uint32_t code)
+{
+	uint16_t low = 0;
+	uint16_t high = font->num_ranges;
+
+	/* Ranges are sorted by first code point */
+	while (low < high) {
+		uint16_t mid = (low + high) / 2;
+		const ssd1306_glyph_range_t *range = &font->ranges[mid];
+
+		if (code < range->first) {
+			high = mid;
+		} else if (code >= (range->first + range->count)) {
+			low = mid + 1;
+		} else {
+			return &font->glyphs[range->glyph_idx + (code - range->first)];
+		}
+	}
+
+	return NULL;
+}
+
+static void draw_glyph(ssd1306_handle_t handle, const ssd1306_font_t *font, const ssd1306_glyph_t *glyph, uint16_t x_origin, uint16_t y_origin)
+{
+	const uint8_t *data = &font->bitmap[glyph->offset];
+	uint8_t num_byte_per_row = (glyph->width + 7) / 8;
+
+	for (uint8_t height_idx = 0; height_idx < font->height; height_idx++) {
+		uint16_t y = y_origin + height_idx;
+		if (y >= handle->height) {
+			break;
+		}
+
+		for (uint8_t width_idx = 0; width_idx < glyph->width; width_idx++) {
+			uint16_t x = x_origin + width_idx;
+			if (x >= handle->width) {
+				break;
+			}
+
+			if (((data[height_idx * num_byte_per_row + width_idx / 8] << (width_idx % 8)) & 0x80) == 0x80) {
+				handle->buf[handle->buf_idx][x + (y / 8)*handle->width] |= (1 << (y % 8));
+			} else {
+				handle->buf[handle->buf_idx][x + (y / 8)*handle->width] &= ~ (1 << (y % 8));
+			}
+		}
+	}
+}
+
+static void dither_write_page(ssd1306_handle_t handle, uint8_t x_origin, uint8_t width, uint8_t page, uint8_t mask, const uint8_t *bits)
+{
+	uint8_t *dst = &handle->buf[handle->buf_idx][page * handle->width + x_origin];
+	uint8_t inv = handle->inverse ? mask : 0x00;
+
+	for (uint8_t x = 0; x < width; x++) {
+		dst[x] = (dst[x] & ~mask) | ((bits[x] ^ inv) & mask);
+	}
+}
+
 static err_code_t ssd1306_spi_write_cmd(ssd1306_handle_t handle, uint8_t cmd)
 {
 	handle->set_cs(SPI_CS_ACTIVE);
@@ -151,6 +315,22 @@ static err_code_t ssd1306_spi_write_cmd(ssd1306_handle_t handle, uint8_t cmd)
 	handle->spi_send(&cmd, 1);
 	handle->set_cs(SPI_CS_UNACTIVE);
 
+	handle->stats.bytes += 1;
+	handle->stats.transactions++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t ssd1306_spi_write_cmds(ssd1306_handle_t handle, uint8_t *cmds, uint16_t len)
+{
+	handle->set_cs(SPI_CS_ACTIVE);
+	handle->set_dc(0);
+	handle->spi_send(cmds, len);
+	handle->set_cs(SPI_CS_UNACTIVE);
+
+	handle->stats.bytes += len;
+	handle->stats.transactions++;
+
 	return ERR_CODE_SUCCESS;
 }
 
@@ -161,6 +341,9 @@ static err_code_t ssd1306_spi_write_data(ssd1306_handle_t handle, uint8_t *data,
 	handle->spi_send(data, len);
 	handle->set_cs(SPI_CS_UNACTIVE);
 
+	handle->stats.bytes += len;
+	handle->stats.transactions++;
+
 	return ERR_CODE_SUCCESS;
 }
 
@@ -168,6 +351,19 @@ static err_code_t ssd1306_i2c_write_cmd(ssd1306_handle_t handle, uint8_t cmd)
 {
 	handle->i2c_send(SSD1306_REG_CMD_ADDR, &cmd, 1);
 
+	handle->stats.bytes += 1;
+	handle->stats.transactions++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t ssd1306_i2c_write_cmds(ssd1306_handle_t handle, uint8_t *cmds, uint16_t len)
+{
+	handle->i2c_send(SSD1306_REG_CMD_ADDR, cmds, len);
+
+	handle->stats.bytes += len;
+	handle->stats.transactions++;
+
 	return ERR_CODE_SUCCESS;
 }
 
@@ -175,9 +371,35 @@ static err_code_t ssd1306_i2c_write_data(ssd1306_handle_t handle, uint8_t *data,
 {
 	handle->i2c_send(SSD1306_REG_DATA_ADDR, data, len);
 
+	handle->stats.bytes += len;
+	handle->stats.transactions++;
+
 	return ERR_CODE_SUCCESS;
 }
 
+static err_code_t ssd1306_set_window(ssd1306_handle_t handle, uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end)
+{
+	uint8_t cmds[6] = {
+		SSD1306_SET_COLUMN_ADDR, col_start, col_end,
+		SSD1306_SET_PAGE_ADDR, page_start, page_end
+	};
+
+	return handle->write_cmds(handle, cmds, sizeof(cmds));
+}
+
+static void send_pages(ssd1306_handle_t handle, uint8_t page_base, uint8_t page_start, uint8_t page_end)
+{
+	ssd1306_set_window(handle, 0, handle->width - 1, page_base + page_start, page_base + page_end);
+	handle->write_data(handle, &handle->buf[handle->buf_idx][page_start * handle->width], (page_end - page_start + 1) * handle->width);
+}
+
+static void write_contrast(ssd1306_handle_t handle, uint8_t contrast)
+{
+	uint8_t cmds[2] = {SSD1306_SET_CONTRAST, contrast};
+
+	handle->write_cmds(handle, cmds, sizeof(cmds));
+}
+
 ssd1306_handle_t ssd1306_init(void)
 {
 	ssd1306_handle_t handle = calloc(1, sizeof(ssd1306_t));
@@ -197,17 +419,26 @@ err_code_t ssd1306_set_config(ssd1306_handle_t handle, ssd1306_cfg_t config)
 		return ERR_CODE_NULL_PTR;
 	}
 
+	/* Page flip uses the hidden half of GDDRAM, only available on 32-row panels */
+	if ((config.page_flip != 0) && (config.height != 32))
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
 	write_cmd_func write_cmd;
+	write_cmds_func write_cmds;
 	write_data_func write_data;
 
 	if (config.comm_mode == SSD1306_COMM_MODE_I2C)
 	{
 		write_cmd = ssd1306_i2c_write_cmd;
+		write_cmds = ssd1306_i2c_write_cmds;
 		write_data = ssd1306_i2c_write_data;
 	}
 	else
 	{
 		write_cmd = ssd1306_spi_write_cmd;
+		write_cmds = ssd1306_spi_write_cmds;
 		write_data = ssd1306_spi_write_data;
 	}
 
@@ -220,12 +451,19 @@ err_code_t ssd1306_set_config(ssd1306_handle_t handle, ssd1306_cfg_t config)
 	handle->set_rst = config.set_rst;
 	handle->spi_send = config.spi_send;
 	handle->i2c_send = config.i2c_send;
+	handle->get_time_us = config.get_time_us;
+	handle->warm_start = config.warm_start;
+	handle->splash = config.splash;
+	handle->page_flip = config.page_flip;
 	handle->write_cmd = write_cmd;
+	handle->write_cmds = write_cmds;
 	handle->write_data = write_data;
 	handle->buf_len = config.width * config.height / 8;
 	handle->buf_idx = 0;
 	handle->pos_x = 0;
 	handle->pos_y = 0;
+	handle->start_page = 0;
+	handle->contrast = ssd1306_init_seq[INIT_SEQ_IDX_CONTRAST];
 
 	return ERR_CODE_SUCCESS;
 }
@@ -238,36 +476,89 @@ err_code_t ssd1306_config(ssd1306_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
+	if (handle->get_time_us != NULL)
+	{
+		handle->time_config = handle->get_time_us();
+	}
+	handle->first_frame_done = 0;
+
+	/* Release buffers of a previous configuration */
+	for (uint8_t i = 0; i < NUM_OF_BUF; i++)
+	{
+		free(handle->buf[i]);
+		handle->buf[i] = NULL;
+	}
+	free(handle->dither_err);
+	handle->dither_err = NULL;
+
 	for (uint8_t i = 0; i < NUM_OF_BUF; i++)
 	{
 		handle->buf[i] = calloc(handle->buf_len, sizeof(uint8_t));
+		if (handle->buf[i] == NULL)
+		{
+			for (uint8_t j = 0; j < i; j++)
+			{
+				free(handle->buf[j]);
+				handle->buf[j] = NULL;
+			}
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	/* Error diffusion keeps two rows of error, with one guard on each side */
+	handle->dither_err = calloc(2 * (handle->width + 2), sizeof(int16_t));
+	if (handle->dither_err == NULL)
+	{
+		for (uint8_t i = 0; i < NUM_OF_BUF; i++)
+		{
+			free(handle->buf[i]);
+			handle->buf[i] = NULL;
+		}
+		return ERR_CODE_FAIL;
+	}
+
+	if (handle->splash != NULL)
+	{
+		memcpy(handle->buf[handle->buf_idx], handle->splash, handle->buf_len);
+	}
+
+	/* Warm start: controller is already configured, keep GDDRAM and settings */
+	if (handle->warm_start == 0)
+	{
+		uint8_t init_seq[sizeof(ssd1306_init_seq)];
+		uint16_t init_len = sizeof(init_seq);
+
+		memcpy(init_seq, ssd1306_init_seq, sizeof(init_seq));
+		init_seq[INIT_SEQ_IDX_DISPLAY_MODE] = handle->inverse == 0 ? SSD1306_DISPLAY_NORMAL : SSD1306_DISPLAY_INVERSE;
+		init_seq[INIT_SEQ_IDX_MULTIPLEX] = handle->height == 32 ? 0x1F : 0x3F;
+		init_seq[INIT_SEQ_IDX_COMPINS] = handle->height == 32 ? 0x02 : 0x12;
+
+		/* Hold display ON until the splash is in GDDRAM */
+		if (handle->splash != NULL)
+		{
+			init_len--;
+		}
+
+		handle->write_cmds(handle, init_seq, init_len);
 	}
 
-	handle->write_cmd(handle, SSD1306_DISPLAY_OFF);
-	handle->write_cmd(handle, SSD1306_SET_MEMORYMODE);
-	handle->write_cmd(handle, SSD1306_SET_MEMORYMODE_HOR);
-	handle->write_cmd(handle, SSD1306_COMSCAN_DEC);
-	handle->write_cmd(handle, 0x00);
-	handle->write_cmd(handle, 0x10);
-	handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO);
-	handle->write_cmd(handle, SSD1306_SET_SEGREMAP_INV);
-	handle->write_cmd(handle, handle->inverse == 0 ? SSD1306_DISPLAY_NORMAL : SSD1306_DISPLAY_INVERSE);
-	handle->write_cmd(handle, 0xFF);
-	handle->write_cmd(handle, handle->width == 32 ? 0x1F : 0x3F );
-	handle->write_cmd(handle, SSD1306_DISPLAYALLON_RESUME);
-	handle->write_cmd(handle, SSD1306_SET_DISPLAYOFFSET);
-	handle->write_cmd(handle, 0x00);
-	handle->write_cmd(handle, SSD1306_SET_CLKDIV);
-	handle->write_cmd(handle, 0xF0);
-	handle->write_cmd(handle, SSD1306_SET_PRECHARGE);
-	handle->write_cmd(handle, 0x22);
-	handle->write_cmd(handle, SSD1306_SET_COMPINS);
-	handle->write_cmd(handle, handle->width == 32 ? 0x02 : 0x12);
-	handle->write_cmd(handle, SSD1306_SET_COMDESELECT);
-	handle->write_cmd(handle, 0x20);
-	handle->write_cmd(handle, SSD1306_CHARGEPUMP);
-	handle->write_cmd(handle, SSD1306_CHARGEPUMP_ON);
-	handle->write_cmd(handle, SSD1306_DISPLAY_ON);
+	/* After a warm start the controller may still show the other half,
+	 * move the start line back so the first refresh writes the hidden one */
+	if ((handle->warm_start != 0) && (handle->page_flip != 0))
+	{
+		handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO);
+	}
+	handle->start_page = 0;
+
+	if (handle->splash != NULL)
+	{
+		ssd1306_refresh(handle);
+
+		if (handle->warm_start == 0)
+		{
+			handle->write_cmd(handle, SSD1306_DISPLAY_ON);
+		}
+	}
 
 	return ERR_CODE_SUCCESS;
 }
@@ -280,12 +571,26 @@ err_code_t ssd1306_refresh(ssd1306_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	for (uint8_t i = 0; i < (handle->height / 8); i++)
+	if (handle->page_flip)
 	{
-		handle->write_cmd(handle, 0xB0 + i);
-		handle->write_cmd(handle, 0x00);
-		handle->write_cmd(handle, 0x10);
-		handle->write_data(handle, &handle->buf[handle->buf_idx][i * handle->width], handle->width);
+		/* Write the hidden half of GDDRAM, then move the start line onto it */
+		uint8_t page_start = handle->start_page ^ (handle->height / 8);
+
+		ssd1306_set_window(handle, 0, handle->width - 1, page_start, page_start + handle->height / 8 - 1);
+		handle->write_data(handle, handle->buf[handle->buf_idx], handle->buf_len);
+		handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO | (page_start * 8));
+		handle->start_page = page_start;
+	}
+	else
+	{
+		ssd1306_set_window(handle, 0, handle->width - 1, 0, handle->height / 8 - 1);
+		handle->write_data(handle, handle->buf[handle->buf_idx], handle->buf_len);
+	}
+
+	if ((handle->first_frame_done == 0) && (handle->get_time_us != NULL))
+	{
+		handle->time_first_frame = handle->get_time_us() - handle->time_config;
+		handle->first_frame_done = 1;
 	}
 
 	return ERR_CODE_SUCCESS;
@@ -560,3 +865,507 @@ err_code_t ssd1306_get_position(ssd1306_handle_t handle, uint8_t *x, uint8_t *y)
 
 	return ERR_CODE_SUCCESS;
 }
+
+err_code_t ssd1306_get_time_to_first_frame(ssd1306_handle_t handle, uint32_t *time_us)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Check if first frame has been measured */
+	if (handle->first_frame_done == 0)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	*time_us = handle->time_first_frame;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_anim_play_frame(ssd1306_handle_t handle, const uint8_t *frame, uint32_t frame_size, uint32_t *frame_len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (frame == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (frame_size < 1)
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	uint8_t num_span = frame[0];
+	uint32_t idx = 1;
+
+	/* Validate the whole frame before touching the buffer or GDDRAM */
+	for (uint8_t span_idx = 0; span_idx < num_span; span_idx++) {
+		if ((idx + ANIM_SPAN_HEADER_LEN) > frame_size) {
+			return ERR_CODE_INVALID_ARG;
+		}
+
+		uint8_t page = frame[idx];
+		uint8_t col = frame[idx + 1];
+		uint8_t len = frame[idx + 2];
+		idx += ANIM_SPAN_HEADER_LEN;
+
+		if ((page >= (handle->height / 8)) || (len == 0) || ((col + len) > handle->width) || ((idx + len) > frame_size)) {
+			return ERR_CODE_INVALID_ARG;
+		}
+		idx += len;
+	}
+
+	idx = 1;
+
+	for (uint8_t span_idx = 0; span_idx < num_span; span_idx++) {
+		uint8_t page = frame[idx];
+		uint8_t col = frame[idx + 1];
+		uint8_t len = frame[idx + 2];
+		idx += ANIM_SPAN_HEADER_LEN;
+
+		uint8_t *dst = &handle->buf[handle->buf_idx][page * handle->width + col];
+		for (uint8_t i = 0; i < len; i++) {
+			dst[i] ^= frame[idx + i];
+		}
+		idx += len;
+
+		ssd1306_set_window(handle, col, col + len - 1, handle->start_page + page, handle->start_page + page);
+		handle->write_data(handle, dst, len);
+	}
+
+	if (frame_len != NULL)
+	{
+		*frame_len = idx;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_anim_encode(const uint8_t *prev, const uint8_t *next, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size, uint32_t *out_len)
+{
+	/* Check if pointers are NULL */
+	if ((prev == NULL) || (next == NULL) || (out == NULL) || (out_len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Page, column and length are stored in one byte each */
+	if ((width == 0) || (width > 255) || ((height / 8) > 255))
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	if (out_size < 1)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint32_t idx = 1;
+	uint16_t num_span = 0;
+
+	for (uint8_t page = 0; page < (height / 8); page++) {
+		const uint8_t *p = &prev[page * width];
+		const uint8_t *n = &next[page * width];
+		uint16_t col = 0;
+
+		while (col < width) {
+			if (p[col] == n[col]) {
+				col++;
+				continue;
+			}
+
+			/* Extend span, bridging unchanged gaps cheaper than a new span header */
+			uint16_t start = col;
+			uint16_t end = col + 1;
+			uint16_t gap = 0;
+			for (col = end; col < width; col++) {
+				if (p[col] != n[col]) {
+					end = col + 1;
+					gap = 0;
+				} else if (++gap > ANIM_SPAN_MERGE_GAP) {
+					break;
+				}
+			}
+			col = end;
+
+			uint16_t len = end - start;
+			if ((num_span == 0xFF) || ((idx + ANIM_SPAN_HEADER_LEN + len) > out_size)) {
+				return ERR_CODE_FAIL;
+			}
+
+			out[idx++] = page;
+			out[idx++] = start;
+			out[idx++] = len;
+			for (uint16_t i = start; i < end; i++) {
+				out[idx++] = p[i] ^ n[i];
+			}
+			num_span++;
+		}
+	}
+
+	out[0] = num_span;
+	*out_len = idx;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_get_stats(ssd1306_handle_t handle, ssd1306_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_reset_stats(ssd1306_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->stats.bytes = 0;
+	handle->stats.transactions = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_write_utf8(ssd1306_handle_t handle, const ssd1306_font_t *font, const uint8_t *str)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (font == NULL) || (str == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->buf_idx ^= 1;
+	memcpy(handle->buf[handle->buf_idx], handle->buf[handle->buf_idx ^ 1], handle->buf_len);
+
+	uint16_t pos_x = handle->pos_x;
+
+	while (*str) {
+		uint32_t code = utf8_decode(&str);
+
+		const ssd1306_glyph_t *glyph = find_glyph(font, code);
+		if (glyph == NULL) {
+			glyph = find_glyph(font, font->fallback);
+			if (glyph == NULL) {
+				continue;
+			}
+		}
+
+		draw_glyph(handle, font, glyph, pos_x, handle->pos_y);
+		pos_x += glyph->advance;
+	}
+
+	handle->pos_x = pos_x;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_refresh_pages(ssd1306_handle_t handle, uint8_t page_start, uint8_t page_end)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((page_start > page_end) || (page_end >= (handle->height / 8)))
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	send_pages(handle, handle->start_page, page_start, page_end);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_refresh_stream(ssd1306_handle_t handle, uint8_t band_pages, ssd1306_func_render_band render, void *arg)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (render == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (band_pages == 0)
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	uint8_t num_page = handle->height / 8;
+
+	/* In page flip mode, stream into the hidden half and flip once at the end */
+	uint8_t page_base = handle->page_flip ? (handle->start_page ^ num_page) : handle->start_page;
+
+	for (uint8_t page_start = 0; page_start < num_page; page_start += band_pages) {
+		uint8_t page_end = page_start + band_pages - 1;
+		if (page_end >= num_page) {
+			page_end = num_page - 1;
+		}
+
+		err_code_t err = render(handle, page_start, page_end, arg);
+		if (err != ERR_CODE_SUCCESS) {
+			return err;
+		}
+
+		send_pages(handle, page_base, page_start, page_end);
+	}
+
+	if (handle->page_flip)
+	{
+		handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO | (page_base * 8));
+		handle->start_page = page_base;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_draw_gray(ssd1306_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, const uint8_t *gray, ssd1306_dither_t dither)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (gray == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((dither >= SSD1306_DITHER_MAX) || ((x_origin + width) > handle->width) || ((y_origin + height) > handle->height))
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	if ((width == 0) || (height == 0))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Page bits of all columns, width is at most 255 */
+	uint8_t bits[255];
+	int16_t *err = handle->dither_err;
+
+	if (dither == SSD1306_DITHER_FLOYD_STEINBERG)
+	{
+		memset(err, 0, 2 * (width + 2) * sizeof(int16_t));
+	}
+
+	handle->buf_idx ^= 1;
+	memcpy(handle->buf[handle->buf_idx], handle->buf[handle->buf_idx ^ 1], handle->buf_len);
+
+	uint16_t y_end = y_origin + height;
+
+	/* Produce eight rows at a time so each buffer byte is written once */
+	for (uint16_t y_page = y_origin & ~0x07; y_page < y_end; y_page += 8) {
+		uint8_t mask = 0;
+
+		memset(bits, 0, width);
+
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			uint16_t y = y_page + bit;
+			if ((y < y_origin) || (y >= y_end)) {
+				continue;
+			}
+
+			const uint8_t *src = &gray[(y - y_origin) * width];
+			mask |= (1 << bit);
+
+			if (dither == SSD1306_DITHER_BAYER) {
+				const uint8_t *threshold = bayer_matrix[y % 8];
+				for (uint8_t x = 0; x < width; x++) {
+					if (src[x] > (threshold[(x_origin + x) % 8] * 4 + 2)) {
+						bits[x] |= (1 << bit);
+					}
+				}
+			} else {
+				int16_t *err_cur = &err[((y - y_origin) % 2) * (width + 2) + 1];
+				int16_t *err_next = &err[((y - y_origin + 1) % 2) * (width + 2) + 1];
+
+				memset(err_next - 1, 0, (width + 2) * sizeof(int16_t));
+
+				for (uint8_t x = 0; x < width; x++) {
+					int16_t value = src[x] + err_cur[x];
+					int16_t error;
+
+					if (value >= 128) {
+						bits[x] |= (1 << bit);
+						error = value - 255;
+					} else {
+						error = value;
+					}
+
+					err_cur[x + 1] += (error * 7) / 16;
+					err_next[x - 1] += (error * 3) / 16;
+					err_next[x] += (error * 5) / 16;
+					err_next[x + 1] += error / 16;
+				}
+			}
+		}
+
+		dither_write_page(handle, x_origin, width, y_page / 8, mask, bits);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_set_contrast(ssd1306_handle_t handle, uint8_t contrast)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	write_contrast(handle, contrast);
+	handle->contrast = contrast;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_transition_step(ssd1306_handle_t handle, ssd1306_transition_t transition, uint8_t step, uint8_t num_step)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((transition >= SSD1306_TRANSITION_MAX) || (step == 0) || (step > num_step))
+	{
+		return ERR_CODE_INVALID_ARG;
+	}
+
+	uint8_t num_page = handle->height / 8;
+
+	switch (transition)
+	{
+	case SSD1306_TRANSITION_FADE_OUT:
+		write_contrast(handle, handle->contrast * (num_step - step) / num_step);
+		if (step == num_step)
+		{
+			handle->write_cmd(handle, SSD1306_DISPLAY_OFF);
+		}
+		break;
+
+	case SSD1306_TRANSITION_FADE_IN:
+		write_contrast(handle, handle->contrast * step / num_step);
+		if (step == 1)
+		{
+			handle->write_cmd(handle, SSD1306_DISPLAY_ON);
+		}
+		break;
+
+	case SSD1306_TRANSITION_SLIDE_UP:
+	{
+		/* Start line is used for flipping in page flip mode */
+		if (handle->page_flip)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		/* Start line wraps modulo GDDRAM rows, only full and half height panels */
+		if ((handle->height != 32) && (handle->height != 64))
+		{
+			return ERR_CODE_INVALID_ARG;
+		}
+
+		/* Pages scrolled off the top wrap to the bottom, replace them by new pages */
+		uint8_t page_start = num_page * (step - 1) / num_step;
+		uint8_t page_end = num_page * step / num_step;
+
+		if (page_end == page_start)
+		{
+			break;
+		}
+
+		if (num_page < GDDRAM_NUM_PAGE)
+		{
+			/* Wrapped rows come from the hidden half: write it before the
+			 * start line moves, then the pages that just left the screen.
+			 * The last step shows the upper half first, so the lower half
+			 * is completed while hidden before going back to start line 0 */
+			send_pages(handle, num_page, page_start, page_end - 1);
+			handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO | (page_end * 8));
+			send_pages(handle, 0, page_start, page_end - 1);
+			if (page_end == num_page)
+			{
+				handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO);
+			}
+		}
+		else
+		{
+			/* No hidden rows: the top pages are overwritten while still visible */
+			send_pages(handle, 0, page_start, page_end - 1);
+			handle->write_cmd(handle, SSD1306_SET_STARTLINE_ZERO | ((page_end % num_page) * 8));
+		}
+		break;
+	}
+
+	case SSD1306_TRANSITION_WIPE_LEFT:
+	case SSD1306_TRANSITION_WIPE_RIGHT:
+	{
+		uint8_t col_start = handle->width * (step - 1) / num_step;
+		uint8_t col_end = handle->width * step / num_step;
+
+		if (col_end == col_start)
+		{
+			break;
+		}
+
+		/* Wipe right reveals from the right edge */
+		if (transition == SSD1306_TRANSITION_WIPE_RIGHT)
+		{
+			uint8_t tmp = col_start;
+			col_start = handle->width - col_end;
+			col_end = handle->width - tmp;
+		}
+
+		/* Window wraps across pages, gather the columns into few transactions */
+		uint8_t data[WIPE_BUF_LEN];
+		uint16_t len = 0;
+
+		ssd1306_set_window(handle, col_start, col_end - 1, handle->start_page, handle->start_page + num_page - 1);
+		for (uint8_t page = 0; page < num_page; page++) {
+			for (uint8_t col = col_start; col < col_end; col++) {
+				data[len++] = handle->buf[handle->buf_idx][page * handle->width + col];
+				if (len == WIPE_BUF_LEN) {
+					handle->write_data(handle, data, len);
+					len = 0;
+				}
+			}
+		}
+
+		if (len != 0)
+		{
+			handle->write_data(handle, data, len);
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t ssd1306_get_buffer(ssd1306_handle_t handle, uint8_t **buf)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (buf == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*buf = handle->buf[handle->buf_idx];
+
+	return ERR_CODE_SUCCESS;
+}
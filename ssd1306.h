@@ -37,12 +37,18 @@ typedef err_code_t (*ssd1306_func_set_dc)(uint8_t level);
 typedef err_code_t (*ssd1306_func_set_rst)(uint8_t level);
 typedef err_code_t (*ssd1306_func_spi_send)(uint8_t *buf_send, uint16_t len);
 typedef err_code_t (*ssd1306_func_i2c_send)(uint8_t reg_addr, uint8_t *buf_send, uint16_t len);
+typedef uint32_t (*ssd1306_func_get_time_us)(void);
 
 /**
  * @brief   Handle structure.
  */
 typedef struct ssd1306 *ssd1306_handle_t;
 
+/**
+ * @brief   Function render a band of pages. Called by ssd1306_refresh_stream.
+ */
+typedef err_code_t (*ssd1306_func_render_band)(ssd1306_handle_t handle, uint8_t page_start, uint8_t page_end, void *arg);
+
 /**
  * @brief   Color.
  */
@@ -52,6 +58,27 @@ typedef enum {
 	SSD1306_COLOR_MAX
 } ssd1306_color_t;
 
+/**
+ * @brief   Dithering method.
+ */
+typedef enum {
+	SSD1306_DITHER_BAYER = 0,					/*!< Ordered dithering, fast */
+	SSD1306_DITHER_FLOYD_STEINBERG,				/*!< Error diffusion, better quality */
+	SSD1306_DITHER_MAX
+} ssd1306_dither_t;
+
+/**
+ * @brief   Screen transition.
+ */
+typedef enum {
+	SSD1306_TRANSITION_FADE_OUT = 0,			/*!< Contrast ramp down, display OFF at the end */
+	SSD1306_TRANSITION_FADE_IN,					/*!< Display ON, contrast ramp up */
+	SSD1306_TRANSITION_SLIDE_UP,				/*!< New screen slides in from the bottom */
+	SSD1306_TRANSITION_WIPE_LEFT,				/*!< New screen revealed from the left edge */
+	SSD1306_TRANSITION_WIPE_RIGHT,				/*!< New screen revealed from the right edge */
+	SSD1306_TRANSITION_MAX
+} ssd1306_transition_t;
+
 /**
  * @brief   Comminication mode.
  */
@@ -61,6 +88,45 @@ typedef enum {
 	SSD1306_COMM_MODE_MAX
 } ssd1306_comm_mode_t;
 
+/**
+ * @brief   Glyph range. Code points first..first+count-1 map to consecutive
+ *          glyphs starting at glyph_idx.
+ */
+typedef struct {
+	uint32_t 				first;			/*!< First code point */
+	uint16_t 				count;			/*!< Number of code points */
+	uint16_t 				glyph_idx;		/*!< Index of the first glyph */
+} ssd1306_glyph_range_t;
+
+/**
+ * @brief   Glyph. Bitmap is row-major, MSB first, (width + 7) / 8 bytes per row.
+ */
+typedef struct {
+	uint32_t 				offset;			/*!< Offset of the bitmap in font bitmap data */
+	uint8_t 				width;			/*!< Bitmap width in pixel */
+	uint8_t 				advance;		/*!< Horizontal advance in pixel */
+} ssd1306_glyph_t;
+
+/**
+ * @brief   Font with sparse glyph index.
+ */
+typedef struct {
+	uint8_t 						height;			/*!< Glyph height in pixel */
+	const ssd1306_glyph_range_t 	*ranges;		/*!< Glyph ranges, sorted by first code point */
+	uint16_t 						num_ranges;		/*!< Number of glyph ranges */
+	const ssd1306_glyph_t 			*glyphs;		/*!< Glyphs */
+	const uint8_t 					*bitmap;		/*!< Bitmap data */
+	uint32_t 						fallback;		/*!< Code point drawn when a glyph is missing */
+} ssd1306_font_t;
+
+/**
+ * @brief   Bus statistics.
+ */
+typedef struct {
+	uint32_t 				bytes;			/*!< Number of bytes sent, commands and data */
+	uint32_t 				transactions;	/*!< Number of bus transactions */
+} ssd1306_stats_t;
+
 /**
  * @brief   Configuration structure.
  */
@@ -74,6 +140,10 @@ typedef struct {
 	ssd1306_func_set_rst 	set_rst;		/*!< Function set RST. Used in SPI mode */
 	ssd1306_func_spi_send 	spi_send;		/*!< Function send SPI data */
 	ssd1306_func_i2c_send 	i2c_send;		/*!< Function send I2C data */
+	ssd1306_func_get_time_us get_time_us;	/*!< Function get time in microsecond. Used to measure time to first frame. Optional */
+	uint8_t 				warm_start;		/*!< Skip initialization sequence, controller is already configured */
+	uint8_t 				*splash;		/*!< Splash framebuffer pushed right after initialization, width * height / 8 bytes in page-major layout. Optional */
+	uint8_t 				page_flip;		/*!< Flip between both halves of GDDRAM on refresh. Only for 32-row panels */
 } ssd1306_cfg_t;
 
 /*
@@ -104,6 +174,11 @@ err_code_t ssd1306_set_config(ssd1306_handle_t handle, ssd1306_cfg_t config);
 /*
  * @brief   Configure SSD1306 to run.
  *
+ * @note    Initialization sequence is sent in one command burst. If splash
+ *          is set, it is pushed before display is turned ON. In warm start
+ *          mode, initialization sequence is skipped. Calling it again
+ *          releases the buffers of the previous configuration.
+ *
  * @param 	handle Handle structure.
  *
  * @return
@@ -115,6 +190,9 @@ err_code_t ssd1306_config(ssd1306_handle_t handle);
 /*
  * @brief   Refresh screen.
  *
+ * @note    In page flip mode, the frame is written to the hidden half of
+ *          GDDRAM and shown by changing the display start line.
+ *
  * @param   handle Handle structure.
  *
  * @return
@@ -123,6 +201,45 @@ err_code_t ssd1306_config(ssd1306_handle_t handle);
  */
 err_code_t ssd1306_refresh(ssd1306_handle_t handle);
 
+/*
+ * @brief   Refresh a band of pages.
+ *
+ * @note    Only reads the buffer rows of the band, so other bands can be
+ *          drawn while it is being sent. In page flip mode, the band is
+ *          written to the visible half.
+ *
+ * @param   handle Handle structure.
+ * @param   page_start First page.
+ * @param   page_end Last page.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_refresh_pages(ssd1306_handle_t handle, uint8_t page_start, uint8_t page_end);
+
+/*
+ * @brief   Render and refresh screen band by band.
+ *
+ * @note    For each band of band_pages pages, in order, render is called
+ *          and the band is sent as soon as it returns. render either draws
+ *          the band itself, or waits until worker threads, which write the
+ *          bands into the buffer from ssd1306_get_buffer, have finished it.
+ *          With workers, the rasterization of later bands overlaps with the
+ *          transfer of finished ones. In page flip mode, bands are written
+ *          to the hidden half which is shown once all bands are sent.
+ *
+ * @param   handle Handle structure.
+ * @param   band_pages Number of pages per band.
+ * @param   render Function render a band.
+ * @param   arg Argument passed to render.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_refresh_stream(ssd1306_handle_t handle, uint8_t band_pages, ssd1306_func_render_band render, void *arg);
+
 /*
  * @brief   Clear screen.
  *
@@ -172,6 +289,23 @@ err_code_t ssd1306_write_char(ssd1306_handle_t handle, font_size_t font_size, ui
  */
 err_code_t ssd1306_write_string(ssd1306_handle_t handle, font_size_t font_size, uint8_t *str);
 
+/*
+ * @brief   Write UTF-8 string.
+ *
+ * @note    Glyphs are looked up by binary search over the font ranges and
+ *          advanced by their own width. Invalid sequences are drawn as
+ *          U+FFFD, missing glyphs as the font fallback.
+ *
+ * @param   handle Handle structure.
+ * @param   font Font.
+ * @param   str Pointer references to the UTF-8 string.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_write_utf8(ssd1306_handle_t handle, const ssd1306_font_t *font, const uint8_t *str);
+
 /*
  * @brief   Draw pixel.
  *
@@ -249,6 +383,23 @@ err_code_t ssd1306_draw_circle(ssd1306_handle_t handle, uint8_t x_origin, uint8_
  */
 err_code_t ssd1306_draw_bitmap(ssd1306_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *bitmap);
 
+/*
+ * @brief   Draw 8-bit grayscale image with dithering.
+ *
+ * @param   handle Handle structure.
+ * @param   x_origin Origin horizontal position.
+ * @param   y_origin Origin vertical position.
+ * @param   width Width in pixel.
+ * @param   height Height in pixel.
+ * @param   gray Grayscale image, row-major, one byte per pixel, 255 is white.
+ * @param   dither Dithering method.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_draw_gray(ssd1306_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, const uint8_t *gray, ssd1306_dither_t dither);
+
 /*
  * @brief   Set current position.
  *
@@ -275,6 +426,135 @@ err_code_t ssd1306_set_position(ssd1306_handle_t handle, uint8_t x, uint8_t y);
  */
 err_code_t ssd1306_get_position(ssd1306_handle_t handle, uint8_t *x, uint8_t *y);
 
+/*
+ * @brief   Get time from ssd1306_config to the end of the first refresh.
+ *
+ * @param   handle Handle structure.
+ * @param   time_us Pointer references to the time in microsecond.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_get_time_to_first_frame(ssd1306_handle_t handle, uint32_t *time_us);
+
+/*
+ * @brief   Play one frame of a delta-encoded animation.
+ *
+ * @note    A frame is a span count (1 byte) followed by the spans. Each span
+ *          is page (1 byte), column (1 byte), length (1 byte) and length
+ *          bytes XOR-ed in place into the current buffer. Only the spans
+ *          are transmitted. The frame is validated before anything is
+ *          applied, an invalid frame leaves buffer and screen unchanged.
+ *
+ * @param   handle Handle structure.
+ * @param   frame Pointer references to the frame.
+ * @param   frame_size Number of bytes available at frame.
+ * @param   frame_len Pointer references to the number of bytes consumed. Optional.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_anim_play_frame(ssd1306_handle_t handle, const uint8_t *frame, uint32_t frame_size, uint32_t *frame_len);
+
+/*
+ * @brief   Encode the delta between two buffers as an animation frame.
+ *
+ * @note    Buffers use the page-major layout of the driver. Does not need a
+ *          handle, so it can be built on the host to produce streams.
+ *          Width must not exceed 255.
+ *
+ * @param   prev Previous buffer.
+ * @param   next Next buffer.
+ * @param   width Screen width.
+ * @param   height Screen height.
+ * @param   out Output frame.
+ * @param   out_size Size of output frame.
+ * @param   out_len Pointer references to the encoded frame length.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_anim_encode(const uint8_t *prev, const uint8_t *next, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size, uint32_t *out_len);
+
+/*
+ * @brief   Get bus statistics since initialization or last reset.
+ *
+ * @param   handle Handle structure.
+ * @param   stats Pointer references to the statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_get_stats(ssd1306_handle_t handle, ssd1306_stats_t *stats);
+
+/*
+ * @brief   Reset bus statistics.
+ *
+ * @param   handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_reset_stats(ssd1306_handle_t handle);
+
+/*
+ * @brief   Set contrast.
+ *
+ * @param   handle Handle structure.
+ * @param   contrast Contrast.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_set_contrast(ssd1306_handle_t handle, uint8_t contrast);
+
+/*
+ * @brief   Run one step of a screen transition.
+ *
+ * @note    Call with step from 1 to num_step, timing is up to the caller.
+ *          The new screen is the current buffer. Fades only change the
+ *          contrast, refresh the new screen between a fade out and a fade
+ *          in. Slides move the display start line and send only the pages
+ *          uncovered by the step, for 32 and 64-row panels, not available in
+ *          page flip mode. On 64-row panels, the new pages overwrite the
+ *          top pages while they are still visible, before the start line
+ *          moves; 32-row panels use the hidden half and do not. Wipes send
+ *          only the columns uncovered by the step, in one transaction per
+ *          128 bytes.
+ *
+ * @param   handle Handle structure.
+ * @param   transition Transition.
+ * @param   step Current step.
+ * @param   num_step Number of steps.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_transition_step(ssd1306_handle_t handle, ssd1306_transition_t transition, uint8_t step, uint8_t num_step);
+
+/*
+ * @brief   Get current buffer.
+ *
+ * @note    Buffer is page-major, width * height / 8 bytes. Drawing functions
+ *          switch buffers, do not call them while the buffer is written
+ *          directly.
+ *
+ * @param   handle Handle structure.
+ * @param   buf Pointer references to the buffer.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t ssd1306_get_buffer(ssd1306_handle_t handle, uint8_t **buf);
+
 #ifdef __cplusplus
 }
 #endif